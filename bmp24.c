@@ -165,42 +165,72 @@ void save_bmp24(t_bmp24 *bmp, const char *filename) {
     fclose(f);
 }
 
+// Crée une vue sur une sous-région de l'image, rognée aux bords de celle-ci
+t_bmp24_view make_view24(t_bmp24 *bmp, int x, int y, int width, int height) {
+    t_bmp24_view view;
+    view.parent = bmp;
+    view.x = x < 0 ? 0 : (x > bmp->width ? bmp->width : x);
+    view.y = y < 0 ? 0 : (y > bmp->height ? bmp->height : y);
+    view.width = width < 0 ? 0 : (width > bmp->width - view.x ? bmp->width - view.x : width);
+    view.height = height < 0 ? 0 : (height > bmp->height - view.y ? bmp->height - view.y : height);
+    return view;
+}
+
+// Vue couvrant l'image entière
+t_bmp24_view make_full_view24(t_bmp24 *bmp) {
+    return make_view24(bmp, 0, 0, bmp->width, bmp->height);
+}
+
 // Inversion des couleurs : effet négatif
 void apply_negative_filter(t_bmp24 *bmp) {
-    for (int y = 0; y < bmp->height; y++) {
-        for (int x = 0; x < bmp->width; x++) {
-            bmp->data[y][x].red   = 255 - bmp->data[y][x].red;
-            bmp->data[y][x].green = 255 - bmp->data[y][x].green;
-            bmp->data[y][x].blue  = 255 - bmp->data[y][x].blue;
+    t_bmp24_view view = make_full_view24(bmp);
+    apply_negative_filter_view(&view);
+}
+
+void apply_negative_filter_view(t_bmp24_view *view) {
+    for (int y = view->y; y < view->y + view->height; y++) {
+        t_pixel *row = view->parent->data[y];
+        for (int x = view->x; x < view->x + view->width; x++) {
+            row[x].red   = 255 - row[x].red;
+            row[x].green = 255 - row[x].green;
+            row[x].blue  = 255 - row[x].blue;
         }
     }
 }
 
 // Conversion de l'image en niveaux de gris
 void apply_grey_filter(t_bmp24 *bmp) {
-    for (int y = 0; y < bmp->height; y++) {
-        for (int x = 0; x < bmp->width; x++) {
-            unsigned char grey = (
-                bmp->data[y][x].red +
-                bmp->data[y][x].green +
-                bmp->data[y][x].blue
-            ) / 3;
-            bmp->data[y][x].red = bmp->data[y][x].green = bmp->data[y][x].blue = grey;
+    t_bmp24_view view = make_full_view24(bmp);
+    apply_grey_filter_view(&view);
+}
+
+void apply_grey_filter_view(t_bmp24_view *view) {
+    for (int y = view->y; y < view->y + view->height; y++) {
+        t_pixel *row = view->parent->data[y];
+        for (int x = view->x; x < view->x + view->width; x++) {
+            unsigned char grey = (row[x].red + row[x].green + row[x].blue) / 3;
+            row[x].red = row[x].green = row[x].blue = grey;
         }
     }
 }
 
 // Ajuste la luminosité globale de l'image
 void adjust_brightness(t_bmp24 *bmp, int brightness) {
-    for (int y = 0; y < bmp->height; y++) {
-        for (int x = 0; x < bmp->width; x++) {
-            int r = bmp->data[y][x].red + brightness;
-            int g = bmp->data[y][x].green + brightness;
-            int b = bmp->data[y][x].blue + brightness;
+    t_bmp24_view view = make_full_view24(bmp);
+    adjust_brightness_view(&view, brightness);
+}
 
-            bmp->data[y][x].red   = r > 255 ? 255 : (r < 0 ? 0 : r);
-            bmp->data[y][x].green = g > 255 ? 255 : (g < 0 ? 0 : g);
-            bmp->data[y][x].blue  = b > 255 ? 255 : (b < 0 ? 0 : b);
+void adjust_brightness_view(t_bmp24_view *view, int brightness) {
+    for (int y = view->y; y < view->y + view->height; y++) {
+        t_pixel *row = view->parent->data[y];
+        for (int x = view->x; x < view->x + view->width; x++) {
+            int r = row[x].red + brightness;
+            int g = row[x].green + brightness;
+            int b = row[x].blue + brightness;
+
+            row[x].red   = r > 255 ? 255 : (r < 0 ? 0 : r);
+            row[x].green = g > 255 ? 255 : (g < 0 ? 0 : g);
+            row[x].blue  = b > 255 ? 255 : (b < 0 ? 0 : b);
         }
     }
 }
@@ -233,3 +263,38 @@ t_pixel convolution_filter(t_bmp24 *bmp, int x, int y, float **kernel, int kerne
     pixel.blue  = (unsigned char)(b_sum > 255 ? 255 : (b_sum < 0 ? 0 : b_sum));
     return pixel;
 }
+
+// Applique une matrice de convolution à toute l'image
+void apply_convolution(t_bmp24 *bmp, float **kernel, int kernel_size) {
+    t_bmp24_view view = make_full_view24(bmp);
+    apply_convolution_view(&view, kernel, kernel_size);
+}
+
+// Applique une matrice de convolution à une région.
+// Les voisins sont lus dans l'image parente (bords répliqués) ; les lignes
+// calculées attendent dans un tampon circulaire qu'aucune ligne restante ne
+// les utilise comme source avant d'être recopiées.
+void apply_convolution_view(t_bmp24_view *view, float **kernel, int kernel_size) {
+    if (view->width <= 0 || view->height <= 0) return;
+
+    int ring_size = kernel_size / 2 + 1;
+    t_pixel **ring = allocate_pixel_table(view->width, ring_size);
+    if (!ring) return;
+
+    int y_end = view->y + view->height;
+    for (int y = view->y; y < y_end + ring_size; y++) {
+        int done = y - ring_size;
+        if (done >= view->y) {
+            memcpy(&view->parent->data[done][view->x],
+                   ring[(done - view->y) % ring_size], view->width * sizeof(t_pixel));
+        }
+        if (y >= y_end) continue;
+
+        t_pixel *out = ring[(y - view->y) % ring_size];
+        for (int x = 0; x < view->width; x++) {
+            out[x] = convolution_filter(view->parent, view->x + x, y, kernel, kernel_size);
+        }
+    }
+
+    free_pixel_table(ring, ring_size);
+}
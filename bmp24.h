@@ -1,3 +1,6 @@
+#ifndef BMP24_H
+#define BMP24_H
+
 #include <stdio.h>
 #include <stdint.h>
 
@@ -61,6 +64,17 @@ typedef struct {
     t_pixel **data;  // Tableau dynamique des pixels
 } t_bmp24;
 
+// Vue sur une sous-région d'une image 24 bits, sans copie des pixels.
+// Les lignes étant allouées séparément, le pas est celui du tableau de lignes.
+// (x, y) est le coin haut-gauche de la région, y compté depuis le haut de l'image.
+typedef struct {
+    t_bmp24 *parent;
+    int x;       // Origine de la région dans l'image parente
+    int y;
+    int width;
+    int height;
+} t_bmp24_view;
+
 // Fonctions de gestion mémoire et lecture/écriture d'image
 t_pixel ** bmp24_allocateDataPixels (int width, int height);
 void bmp24_freeDataPixels (t_pixel ** pixels, int height);
@@ -78,3 +92,22 @@ void bmp24_writePixelData (t_bmp24 * image, FILE * file);
 // Fonctions principales pour charger et sauvegarder une image BMP
 t_bmp24 * bmp24_loadImage (const char * filename);
 void bmp24_saveImage (t_bmp24 * img, const char * filename);
+
+// Vues sur une sous-région de l'image
+t_bmp24_view make_view24 (t_bmp24 * bmp, int x, int y, int width, int height);
+t_bmp24_view make_full_view24 (t_bmp24 * bmp);
+
+// Filtres sur l'image entière
+void apply_negative_filter (t_bmp24 * bmp);
+void apply_grey_filter (t_bmp24 * bmp);
+void adjust_brightness (t_bmp24 * bmp, int brightness);
+t_pixel convolution_filter (t_bmp24 * bmp, int x, int y, float ** kernel, int kernel_size);
+void apply_convolution (t_bmp24 * bmp, float ** kernel, int kernel_size);
+
+// Filtres restreints à une vue (les voisins sont lus dans l'image parente)
+void apply_negative_filter_view (t_bmp24_view * view);
+void apply_grey_filter_view (t_bmp24_view * view);
+void adjust_brightness_view (t_bmp24_view * view, int brightness);
+void apply_convolution_view (t_bmp24_view * view, float ** kernel, int kernel_size);
+
+#endif
@@ -1,21 +1,30 @@
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include "bmp8.h"
 
 #include <stdio.h>
 
-t_bmp8 *bmp8_loadImage(const char *filename) {
+// Largeur ou hauteur maximale acceptée au chargement
+#define BMP8_MAX_DIMENSION 65535u
+
+// Lecture commune de l'en-tête, de la palette et des pixels.
+// Les pixels sont lus dans *buffer, agrandi si sa capacité est insuffisante.
+// Retourne NULL en cas de succès, sinon le message d'erreur.
+static const char *read_image(const char *filename, t_bmp8 *img, unsigned char **buffer, size_t *capacity) {
     FILE *image = fopen(filename, "rb");
 
     // Vérifie si le fichier existe
     if (image == NULL) {
-        printf("Erreur : le fichier n'existe pas ou ne peut pas être ouvert !\n");
-        return NULL;
+        return "le fichier n'existe pas ou ne peut pas être ouvert !";
     }
 
     // Lit l'en-tête BMP (54 octets)
     unsigned char header[54];
-    fread(header, sizeof(unsigned char), 54, image);
+    if (fread(header, sizeof(unsigned char), 54, image) != 54) {
+        fclose(image);
+        return "en-tête BMP incomplet !";
+    }
 
     // Récupère les informations de l'image depuis l'en-tête
     unsigned int width = *(unsigned int*)&header[18];
@@ -25,67 +34,138 @@ t_bmp8 *bmp8_loadImage(const char *filename) {
 
     // Vérifie si l'image est bien en 8 bits
     if (colorDepth != 8) {
-        printf("Erreur : l'image n'est pas en niveau de gris (8 bits) !\n");
         fclose(image);
-        return NULL;
+        return "l'image n'est pas en niveau de gris (8 bits) !";
     }
 
-    // Réservation mémoire pour l'image BMP
-    t_bmp8 *bmpImage = (t_bmp8 *)malloc(sizeof(t_bmp8));
+    // Dimensions nulles ou aberrantes (une hauteur négative apparaît ici comme très grande)
+    if (width == 0 || height == 0 || width > BMP8_MAX_DIMENSION || height > BMP8_MAX_DIMENSION) {
+        fclose(image);
+        return "dimensions de l'image invalides !";
+    }
+
+    // Les lignes sont alignées sur 4 octets ; la taille totale doit tenir dans dataSize.
+    // Une taille brute nulle est permise par le format.
+    size_t stride = ((size_t)width + 3) & ~(size_t)3;
+    if ((size_t)height > UINT_MAX / stride) {
+        fclose(image);
+        return "image trop grande !";
+    }
+    size_t expected = stride * height;
+    if (dataSize == 0) dataSize = expected;
+    if (dataSize < expected) {
+        fclose(image);
+        return "taille des données incohérente avec les dimensions !";
+    }
+
+    // Réserve ou agrandit le tampon des pixels
+    if (*capacity < dataSize) {
+        unsigned char *grown = (unsigned char *)realloc(*buffer, dataSize);
+        if (!grown) {
+            fclose(image);
+            return "échec de l'allocation mémoire des pixels !";
+        }
+        *buffer = grown;
+        *capacity = dataSize;
+    }
 
     // Copie des en-têtes et de la palette de couleurs
-    memcpy(bmpImage->header, header, 54);
-    fread(bmpImage->colorTable, sizeof(unsigned char), 1024, image);
+    memcpy(img->header, header, 54);
+    fread(img->colorTable, sizeof(unsigned char), 1024, image);
 
     // Stocke les propriétés dans la structure
-    bmpImage->width = width;
-    bmpImage->height = height;
-    bmpImage->colorDepth = colorDepth;
-    bmpImage->dataSize = dataSize;
-
-    // Alloue la mémoire pour les données pixel
-    bmpImage->data = (unsigned char *)malloc(dataSize);
+    img->width = width;
+    img->height = height;
+    img->colorDepth = colorDepth;
+    img->dataSize = dataSize;
+    img->data = *buffer;
 
     // Se place à l’emplacement des données et les lit
     fseek(image, *(unsigned int*)&header[10], SEEK_SET);
-    fread(bmpImage->data, sizeof(unsigned char), dataSize, image);
-
-    // Ferme le fichier et retourne l’image chargée
+    size_t read = fread(img->data, sizeof(unsigned char), dataSize, image);
     fclose(image);
+
+    if (read != dataSize) {
+        return "données image incomplètes !";
+    }
+    return NULL;
+}
+
+t_bmp8 *bmp8_loadImage(const char *filename) {
+    // Réservation mémoire pour l'image BMP
+    t_bmp8 *bmpImage = (t_bmp8 *)malloc(sizeof(t_bmp8));
+    if (!bmpImage) {
+        printf("Erreur : échec lors de l'allocation mémoire de l'image.\n");
+        return NULL;
+    }
+
+    unsigned char *data = NULL;
+    size_t capacity = 0;
+    const char *error = read_image(filename, bmpImage, &data, &capacity);
+    if (error) {
+        printf("Erreur : %s\n", error);
+        free(data);
+        free(bmpImage);
+        return NULL;
+    }
+
     printf("Image chargée avec succès !\n\n");
     return bmpImage;
 }
 
-void bmp8_saveImage(const char *filename, t_bmp8 *img) {
+// Charge une image dans une structure fournie par l'appelant, sans message.
+// Les pixels sont lus dans *buffer, réutilisé d'un appel à l'autre et agrandi
+// si nécessaire ; l'appelant reste propriétaire du tampon (ne pas appeler bmp8_free).
+// Retourne 1 en cas de succès, 0 sinon.
+int bmp8_loadImageInto(const char *filename, t_bmp8 *img, unsigned char **buffer, size_t *capacity) {
+    return read_image(filename, img, buffer, capacity) == NULL;
+}
+
+// Écriture commune de l'en-tête, de la palette et des pixels.
+// Retourne NULL en cas de succès, sinon le message d'erreur.
+static const char *write_image(const char *filename, t_bmp8 *img) {
     // Ouvre le fichier en écriture binaire
     FILE *file = fopen(filename, "wb");
     if (!file) {
-        printf("Erreur : impossible d'ouvrir le fichier pour l’écriture.\n");
-        return;
+        return "impossible d'ouvrir le fichier pour l’écriture.";
     }
 
     // Écriture de l'en-tête BMP
     if (fwrite(img->header, sizeof(unsigned char), 54, file) != 54) {
-        printf("Erreur lors de l'écriture de l'en-tête.\n");
         fclose(file);
-        return;
+        return "échec de l'écriture de l'en-tête.";
     }
 
     // Écriture de la table de couleurs
     if (fwrite(img->colorTable, sizeof(unsigned char), 1024, file) != 1024) {
-        printf("Erreur lors de l'écriture de la palette de couleurs.\n");
         fclose(file);
-        return;
+        return "échec de l'écriture de la palette de couleurs.";
     }
 
     // Écriture des données de pixels
     if (fwrite(img->data, sizeof(unsigned char), img->dataSize, file) != img->dataSize) {
-        printf("Erreur lors de l'écriture des données image.\n");
         fclose(file);
-        return;
+        return "échec de l'écriture des données image.";
     }
 
-    fclose(file);
+    // Les données encore en tampon peuvent échouer à la fermeture (disque plein)
+    if (fclose(file) != 0) {
+        return "échec de l'écriture des données image.";
+    }
+    return NULL;
+}
+
+void bmp8_saveImage(const char *filename, t_bmp8 *img) {
+    const char *error = write_image(filename, img);
+    if (error) {
+        printf("Erreur : %s\n", error);
+    }
+}
+
+// Sauvegarde sans message, pour les appelants qui rapportent eux-mêmes l'erreur.
+// Retourne 1 en cas de succès, 0 sinon.
+int bmp8_saveImageTo(const char *filename, t_bmp8 *img) {
+    return write_image(filename, img) == NULL;
 }
 
 // Libère la mémoire allouée pour l'image BMP
@@ -103,61 +183,143 @@ void bmp8_printInfo(t_bmp8 *img) {
     printf("    Taille brute  : %d octets\n\n", img->dataSize);
 }
 
+// Crée une vue sur une sous-région de l'image, rognée aux bords de celle-ci.
+// y est compté depuis le haut de l'image, même si les lignes sont stockées de bas en haut.
+t_bmp8_view bmp8_view(t_bmp8 *img, unsigned int x, unsigned int y, unsigned int width, unsigned int height) {
+    t_bmp8_view view;
+    view.parent = img;
+    view.x = x < img->width ? x : img->width;
+    view.y = y < img->height ? y : img->height;
+    view.width = width < img->width - view.x ? width : img->width - view.x;
+    view.height = height < img->height - view.y ? height : img->height - view.y;
+    view.stride = (img->width + 3) & ~3u;  // Lignes BMP alignées sur 4 octets
+    return view;
+}
+
+// Adresse du premier pixel de la ligne i de la vue (i = 0 en haut)
+static unsigned char *view_row(t_bmp8_view *view, unsigned int i) {
+    unsigned int storedRow = view->parent->height - 1 - (view->y + i);
+    return view->parent->data + storedRow * view->stride + view->x;
+}
+
+// Vue couvrant l'image entière
+t_bmp8_view bmp8_fullView(t_bmp8 *img) {
+    return bmp8_view(img, 0, 0, img->width, img->height);
+}
+
 // Applique un effet négatif à l'image
 void bmp8_negative(t_bmp8 *img) {
-    for (int i = 0; i < img->height; i++) {
-        for (int j = 0; j < img->width; j++) {
-            img->data[i + j * img->width] = 255 - img->data[i + j * img->width];
+    t_bmp8_view view = bmp8_fullView(img);
+    bmp8_negativeView(&view);
+}
+
+// Applique un effet négatif à une région
+void bmp8_negativeView(t_bmp8_view *view) {
+    for (unsigned int i = 0; i < view->height; i++) {
+        unsigned char *row = view_row(view, i);
+        for (unsigned int j = 0; j < view->width; j++) {
+            row[j] = 255 - row[j];
         }
     }
 }
 
 // Ajuste la luminosité de l'image
 void bmp8_brightness(t_bmp8 *img, int value) {
-    for (int i = 0; i < img->height; i++) {
-        for (int j = 0; j < img->width; j++) {
-            int index = i * img->width + j;
-            int pixel = img->data[index] + value;
+    t_bmp8_view view = bmp8_fullView(img);
+    bmp8_brightnessView(&view, value);
+}
+
+// Ajuste la luminosité d'une région
+void bmp8_brightnessView(t_bmp8_view *view, int value) {
+    for (unsigned int i = 0; i < view->height; i++) {
+        unsigned char *row = view_row(view, i);
+        for (unsigned int j = 0; j < view->width; j++) {
+            int pixel = row[j] + value;
 
             if (pixel > 255) pixel = 255;
             else if (pixel < 0) pixel = 0;
 
-            img->data[index] = pixel;
+            row[j] = pixel;
         }
     }
 }
 
 // Applique un seuillage binaire
 void bmp8_threshold(t_bmp8 *img, int threshold) {
-    for (int i = 0; i < img->height; i++) {
-        for (int j = 0; j < img->width; j++) {
-            int index = i * img->width + j;
-            img->data[index] = (img->data[index] >= threshold) ? 255 : 0;
+    t_bmp8_view view = bmp8_fullView(img);
+    bmp8_thresholdView(&view, threshold);
+}
+
+// Applique un seuillage binaire à une région
+void bmp8_thresholdView(t_bmp8_view *view, int threshold) {
+    for (unsigned int i = 0; i < view->height; i++) {
+        unsigned char *row = view_row(view, i);
+        for (unsigned int j = 0; j < view->width; j++) {
+            row[j] = (row[j] >= threshold) ? 255 : 0;
         }
     }
 }
 
 // Applique un filtre de convolution à l'image
 void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize) {
-    // Balayage des pixels en évitant les bords
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
+    t_bmp8_view view = bmp8_fullView(img);
+    bmp8_applyFilterView(&view, kernel, kernelSize);
+}
+
+// Applique un filtre de convolution à une région.
+// Les voisins hors de la région sont lus dans l'image parente ; les pixels dont
+// le voisinage sort de l'image parente restent inchangés. Chaque ligne calculée
+// est gardée dans un tampon circulaire jusqu'à ce qu'elle ne serve plus de
+// source, ce qui évite de copier la région.
+void bmp8_applyFilterView(t_bmp8_view *view, float **kernel, int kernelSize) {
+    t_bmp8 *img = view->parent;
+    int half = kernelSize / 2;
+
+    // Zone réellement traitée, en lignes de stockage (de bas en haut) : la vue,
+    // privée des bords de l'image parente
+    int firstRow = (int)img->height - (int)(view->y + view->height);
+    int xStart = (int)view->x > half ? (int)view->x : half;
+    int yStart = firstRow > half ? firstRow : half;
+    int xEnd = (int)(view->x + view->width);
+    int yEnd = (int)img->height - (int)view->y;
+    if (xEnd > (int)img->width - half) xEnd = (int)img->width - half;
+    if (yEnd > (int)img->height - half) yEnd = (int)img->height - half;
+    if (xStart >= xEnd || yStart >= yEnd) return;
+
+    int rowLength = xEnd - xStart;
+    int ringSize = half + 1;
+    unsigned char *ring = (unsigned char *)malloc(ringSize * rowLength);
+    if (!ring) {
+        printf("Erreur d'allocation mémoire pour le filtre.\n");
+        return;
+    }
+
+    for (int y = yStart; y < yEnd + ringSize; y++) {
+        // La ligne y - half - 1 n'est plus lue par la suite : on la recopie
+        int done = y - ringSize;
+        if (done >= yStart) {
+            memcpy(img->data + done * view->stride + xStart,
+                   ring + ((done - yStart) % ringSize) * rowLength, rowLength);
+        }
+        if (y >= yEnd) continue;
+
+        unsigned char *out = ring + ((y - yStart) % ringSize) * rowLength;
+        for (int x = xStart; x < xEnd; x++) {
             float value = 0.0;
 
-            for (int i = -kernelSize / 2; i <= kernelSize / 2; i++) {
-                for (int j = -kernelSize / 2; j <= kernelSize / 2; j++) {
-                    int neighborX = x + j;
-                    int neighborY = y + i;
-                    int index = neighborY * img->width + neighborX;
-                    value += img->data[index] * kernel[i + kernelSize / 2][j + kernelSize / 2];
+            for (int i = -half; i <= half; i++) {
+                for (int j = -half; j <= half; j++) {
+                    int index = (y + i) * view->stride + (x + j);
+                    value += img->data[index] * kernel[i + half][j + half];
                 }
             }
 
-            int currentIndex = y * img->width + x;
             if (value > 255) value = 255;
             else if (value < 0) value = 0;
 
-            img->data[currentIndex] = (unsigned char)value;
+            out[x - xStart] = (unsigned char)value;
         }
     }
+
+    free(ring);
 }
@@ -1,6 +1,8 @@
 #ifndef BMP8_H
 #define BMP8_H
 
+#include <stddef.h>
+
 typedef struct {
     unsigned char header[54];
     unsigned char colorTable[1024];
@@ -11,8 +13,22 @@ typedef struct {
     unsigned int dataSize;
 } t_bmp8;
 
+// Vue sur une sous-région d'une image, sans copie des pixels.
+// Comme pour t_bmp24_view, (x, y) est le coin haut-gauche de la région,
+// y étant compté depuis la ligne du haut de l'image.
+typedef struct {
+    t_bmp8 *parent;
+    unsigned int x;       // Origine de la région dans l'image parente
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+    unsigned int stride;  // Octets entre deux lignes de l'image parente (largeur alignée sur 4)
+} t_bmp8_view;
+
 t_bmp8 *bmp8_loadImage(const char *filename);
+int bmp8_loadImageInto(const char *filename, t_bmp8 *img, unsigned char **buffer, size_t *capacity);
 void bmp8_saveImage(const char *filename, t_bmp8 *img);
+int bmp8_saveImageTo(const char *filename, t_bmp8 *img);
 void bmp8_free(t_bmp8 *img);
 void bmp8_printInfo(t_bmp8 *img);
 void bmp8_negative(t_bmp8 *img);
@@ -20,4 +36,11 @@ void bmp8_brightness(t_bmp8 *img, int value);
 void bmp8_threshold(t_bmp8 *img, int threshold);
 void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize);
 
+t_bmp8_view bmp8_view(t_bmp8 *img, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+t_bmp8_view bmp8_fullView(t_bmp8 *img);
+void bmp8_negativeView(t_bmp8_view *view);
+void bmp8_brightnessView(t_bmp8_view *view, int value);
+void bmp8_thresholdView(t_bmp8_view *view, int threshold);
+void bmp8_applyFilterView(t_bmp8_view *view, float **kernel, int kernelSize);
+
 #endif
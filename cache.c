@@ -0,0 +1,544 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include "cache.h"
+
+// Constantes premières de l'algorithme XXH64
+#define PRIME64_1 11400714785074694791ULL
+#define PRIME64_2 14029467366897019727ULL
+#define PRIME64_3 1609587929392839161ULL
+#define PRIME64_4 9650029242287828579ULL
+#define PRIME64_5 2870177450012600261ULL
+
+// Nombre d'alvéoles de la table de hachage des entrées
+#define CACHE_BUCKETS 1024
+
+// Suffixe des fichiers de résultats dans le répertoire du cache
+#define CACHE_FILE_SUFFIX ".cache"
+
+static size_t disk_trim(const t_cache *cache, size_t limit, unsigned long *removed);
+
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t xxh_round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static uint64_t xxh_merge(uint64_t acc, uint64_t val) {
+    acc ^= xxh_round(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+// Hachage XXH64 d'un bloc mémoire
+uint64_t cache_hash(const void *data, size_t size, uint64_t seed) {
+    const unsigned char *p = (const unsigned char *)data;
+    const unsigned char *end = p + size;
+    uint64_t h;
+
+    // Traitement par blocs de 32 octets sur quatre accumulateurs
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+
+        while (p + 32 <= end) {
+            v1 = xxh_round(v1, read64(p));
+            v2 = xxh_round(v2, read64(p + 8));
+            v3 = xxh_round(v3, read64(p + 16));
+            v4 = xxh_round(v4, read64(p + 24));
+            p += 32;
+        }
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    } else {
+        h = seed + PRIME64_5;
+    }
+
+    h += (uint64_t)size;
+
+    // Octets restants
+    while (p + 8 <= end) {
+        h ^= xxh_round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        p++;
+    }
+
+    // Mélange final
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Initialise une chaîne d'opérations vide
+void cache_chainInit(t_op_chain *chain) {
+    chain->hash = 0;
+    chain->count = 0;
+}
+
+// Ajoute une opération et ses paramètres au hachage courant de la chaîne.
+// Le nom (avec son zéro final) et le nombre de paramètres délimitent chaque
+// opération, deux chaînes différentes donnent donc deux encodages différents.
+void cache_chainAppend(t_op_chain *chain, const char *name, const float *params, int count) {
+    uint64_t h = cache_hash(name, strlen(name) + 1, chain->hash);
+    h = cache_hash(&count, sizeof(count), h);
+    if (count > 0) {
+        h = cache_hash(params, count * sizeof(float), h);
+    }
+    chain->hash = h;
+    chain->count++;
+}
+
+// Hachage d'une image 8 bits : pixels puis dimensions
+uint64_t cache_hashBmp8(const t_bmp8 *img) {
+    uint64_t h = cache_hash(img->data, img->dataSize, 8);
+    h = cache_hash(&img->width, sizeof(img->width), h);
+    return cache_hash(&img->height, sizeof(img->height), h);
+}
+
+// Hachage d'une image 24 bits : les lignes sont hachées l'une après l'autre
+uint64_t cache_hashBmp24(const t_bmp24 *img) {
+    uint64_t h = 24;
+    for (int y = 0; y < img->height; y++) {
+        h = cache_hash(img->data[y], img->width * sizeof(t_pixel), h);
+    }
+    h = cache_hash(&img->width, sizeof(img->width), h);
+    return cache_hash(&img->height, sizeof(img->height), h);
+}
+
+// Combine le hachage d'une image et celui de la chaîne d'opérations
+uint64_t cache_key(uint64_t imageHash, const t_op_chain *chain) {
+    uint64_t parts[4] = { CACHE_KEY_VERSION, imageHash, chain->hash, chain->count };
+    return cache_hash(parts, sizeof(parts), 0);
+}
+
+uint64_t cache_keyBmp8(const t_bmp8 *img, const t_op_chain *chain) {
+    return cache_key(cache_hashBmp8(img), chain);
+}
+
+uint64_t cache_keyBmp24(const t_bmp24 *img, const t_op_chain *chain) {
+    return cache_key(cache_hashBmp24(img), chain);
+}
+
+// Création d'un cache vide
+t_cache *cache_create(size_t maxBytes, const char *diskDir, size_t maxDiskBytes) {
+    t_cache *cache = malloc(sizeof(t_cache));
+    if (!cache) {
+        printf("Erreur : échec lors de l'allocation mémoire du cache.\n");
+        return NULL;
+    }
+
+    cache->buckets = calloc(CACHE_BUCKETS, sizeof(t_cache_entry *));
+    if (!cache->buckets) {
+        printf("Erreur : échec lors de l'allocation de la table du cache.\n");
+        free(cache);
+        return NULL;
+    }
+
+    cache->bucketCount = CACHE_BUCKETS;
+    cache->head = NULL;
+    cache->tail = NULL;
+    cache->maxBytes = maxBytes;
+    cache->usedBytes = 0;
+    cache->diskDir = diskDir ? strdup(diskDir) : NULL;
+    cache->maxDiskBytes = maxDiskBytes;
+    cache->diskBytes = 0;
+    cache->tempCounter = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+    cache->diskEvictions = 0;
+    cache->trimming = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+
+    // Le répertoire peut contenir des résultats d'exécutions précédentes
+    if (cache->diskDir) cache->diskBytes = disk_trim(cache, maxDiskBytes, &cache->diskEvictions);
+    return cache;
+}
+
+// Libération du cache et de toutes ses entrées en mémoire
+void cache_free(t_cache *cache) {
+    t_cache_entry *entry = cache->head;
+    while (entry) {
+        t_cache_entry *next = entry->next;
+        free(entry->data);
+        free(entry);
+        entry = next;
+    }
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->buckets);
+    free(cache->diskDir);
+    free(cache);
+}
+
+// Retire une entrée de la liste LRU
+static void lru_unlink(t_cache *cache, t_cache_entry *entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache->head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache->tail = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+// Place une entrée en tête de la liste LRU
+static void lru_pushFront(t_cache *cache, t_cache_entry *entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head) cache->head->prev = entry;
+    cache->head = entry;
+    if (!cache->tail) cache->tail = entry;
+}
+
+static t_cache_entry *lookup(t_cache *cache, uint64_t key) {
+    t_cache_entry *entry = cache->buckets[key % cache->bucketCount];
+    while (entry && entry->key != key) {
+        entry = entry->bucketNext;
+    }
+    return entry;
+}
+
+static void free_entry(t_cache_entry *entry) {
+    free(entry->data);
+    free(entry);
+}
+
+// Supprime une entrée de la table et de la liste, puis la libère
+// (plus tard si une copie est en cours). Appelée verrou pris.
+static void remove_entry(t_cache *cache, t_cache_entry *entry) {
+    t_cache_entry **link = &cache->buckets[entry->key % cache->bucketCount];
+    while (*link != entry) {
+        link = &(*link)->bucketNext;
+    }
+    *link = entry->bucketNext;
+
+    lru_unlink(cache, entry);
+    cache->usedBytes -= entry->size;
+    if (entry->refs > 0) entry->detached = 1;
+    else free_entry(entry);
+}
+
+// Insertion en mémoire avec éviction des entrées les moins récentes.
+// La copie est faite avant de prendre le verrou, qui ne couvre que l'index.
+static void memory_store(t_cache *cache, uint64_t key, const void *src, size_t size) {
+    if (size > cache->maxBytes) return;
+
+    t_cache_entry *entry = malloc(sizeof(t_cache_entry));
+    if (!entry) return;
+    entry->data = malloc(size);
+    if (!entry->data) {
+        free(entry);
+        return;
+    }
+
+    memcpy(entry->data, src, size);
+    entry->key = key;
+    entry->size = size;
+    entry->refs = 0;
+    entry->detached = 0;
+
+    pthread_mutex_lock(&cache->lock);
+    t_cache_entry *old = lookup(cache, key);
+    if (old) remove_entry(cache, old);
+
+    while (cache->tail && cache->usedBytes + size > cache->maxBytes) {
+        remove_entry(cache, cache->tail);
+        cache->evictions++;
+    }
+
+    entry->bucketNext = cache->buckets[key % cache->bucketCount];
+    cache->buckets[key % cache->bucketCount] = entry;
+    lru_pushFront(cache, entry);
+    cache->usedBytes += size;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static void disk_path(const t_cache *cache, uint64_t key, char *path, size_t size) {
+    snprintf(path, size, "%s/%016llx.cache", cache->diskDir, (unsigned long long)key);
+}
+
+// Fichier de résultat présent dans le répertoire du cache
+typedef struct {
+    char name[64];
+    size_t size;
+    struct timespec mtime;
+} t_disk_file;
+
+static int compare_mtime(const void *a, const void *b) {
+    const struct timespec *ta = &((const t_disk_file *)a)->mtime;
+    const struct timespec *tb = &((const t_disk_file *)b)->mtime;
+    if (ta->tv_sec != tb->tv_sec) return (ta->tv_sec > tb->tv_sec) - (ta->tv_sec < tb->tv_sec);
+    return (ta->tv_nsec > tb->tv_nsec) - (ta->tv_nsec < tb->tv_nsec);
+}
+
+// Parcourt le répertoire du cache et supprime les résultats les moins récemment
+// utilisés (date de modification, rafraîchie à chaque succès) jusqu'à ne plus
+// dépasser limit. Retourne la place occupée ensuite et ajoute le nombre de
+// fichiers supprimés à *removed.
+static size_t disk_trim(const t_cache *cache, size_t limit, unsigned long *removed) {
+    DIR *dir = opendir(cache->diskDir);
+    if (!dir) return 0;
+
+    t_disk_file *files = NULL;
+    size_t count = 0, capacity = 0, total = 0;
+    size_t suffixLength = strlen(CACHE_FILE_SUFFIX);
+    char path[1024];
+    struct dirent *item;
+
+    while ((item = readdir(dir)) != NULL) {
+        size_t length = strlen(item->d_name);
+        if (length <= suffixLength || length >= sizeof(files->name)
+            || strcmp(item->d_name + length - suffixLength, CACHE_FILE_SUFFIX) != 0) {
+            continue;
+        }
+
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", cache->diskDir, item->d_name);
+        if (stat(path, &st) < 0 || !S_ISREG(st.st_mode)) continue;
+
+        if (count == capacity) {
+            size_t grown = capacity ? capacity * 2 : 64;
+            t_disk_file *larger = realloc(files, grown * sizeof(t_disk_file));
+            if (!larger) break;
+            files = larger;
+            capacity = grown;
+        }
+        strcpy(files[count].name, item->d_name);
+        files[count].size = st.st_size;
+        files[count].mtime = st.st_mtim;
+        total += st.st_size;
+        count++;
+    }
+    closedir(dir);
+
+    if (total > limit) {
+        qsort(files, count, sizeof(t_disk_file), compare_mtime);
+        for (size_t i = 0; i < count && total > limit; i++) {
+            snprintf(path, sizeof(path), "%s/%s", cache->diskDir, files[i].name);
+            if (remove(path) == 0) {
+                total -= files[i].size;
+                (*removed)++;
+            }
+        }
+    }
+
+    free(files);
+    return total;
+}
+
+// Lecture d'un résultat stocké sur disque (taille sur 8 octets puis données)
+static int disk_fetch(const t_cache *cache, uint64_t key, void *dst, size_t size) {
+    char path[1024];
+    disk_path(cache, key, path, sizeof(path));
+
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+
+    uint64_t stored;
+    int ok = fread(&stored, sizeof(stored), 1, f) == 1
+          && stored == size
+          && fread(dst, 1, size, f) == size;
+    fclose(f);
+
+    // Rafraîchit la date du fichier : l'éviction retire les moins récemment utilisés
+    if (ok) utime(path, NULL);
+    return ok;
+}
+
+// Écrit dans un fichier temporaire puis le renomme : un autre processus
+// partageant le répertoire ne voit jamais de résultat à moitié écrit.
+// Seuls le numéro du fichier temporaire et la comptabilité sont pris sous verrou.
+static void disk_store(t_cache *cache, uint64_t key, const void *src, size_t size) {
+    size_t fileSize = size + sizeof(uint64_t);
+    if (fileSize > cache->maxDiskBytes) return;
+
+    pthread_mutex_lock(&cache->lock);
+    unsigned long counter = cache->tempCounter++;
+    pthread_mutex_unlock(&cache->lock);
+
+    char path[1024], temp[1024];
+    disk_path(cache, key, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s/%016llx.%ld.%lu.tmp", cache->diskDir,
+             (unsigned long long)key, (long)getpid(), counter);
+
+    FILE *f = fopen(temp, "wb");
+    if (!f) {
+        printf("Erreur : impossible d'écrire le cache sur disque (%s).\n", temp);
+        return;
+    }
+
+    uint64_t stored = size;
+    int ok = fwrite(&stored, sizeof(stored), 1, f) == 1 && fwrite(src, 1, size, f) == size;
+    if (fclose(f) != 0) ok = 0;
+    if (!ok || rename(temp, path) != 0) {
+        printf("Erreur lors de l'écriture du cache sur disque.\n");
+        remove(temp);
+        return;
+    }
+
+    // Au-delà du plafond, on redescend à 90 % pour ne pas parcourir le répertoire à chaque ajout.
+    // Un seul thread s'en charge, sans bloquer les autres pendant le parcours ; il recommence
+    // si les ajouts faits entre-temps ont de nouveau dépassé le plafond.
+    pthread_mutex_lock(&cache->lock);
+    cache->diskBytes += fileSize;
+    int trim = cache->diskBytes > cache->maxDiskBytes && !cache->trimming;
+    if (trim) cache->trimming = 1;
+    size_t before = cache->diskBytes;
+    pthread_mutex_unlock(&cache->lock);
+
+    while (trim) {
+        unsigned long removed = 0;
+        size_t total = disk_trim(cache, cache->maxDiskBytes - cache->maxDiskBytes / 10, &removed);
+
+        pthread_mutex_lock(&cache->lock);
+        // Les ajouts faits pendant le parcours ne sont peut-être pas comptés dans total
+        cache->diskBytes = total + (cache->diskBytes - before);
+        cache->diskEvictions += removed;
+        trim = cache->diskBytes > cache->maxDiskBytes;
+        if (!trim) cache->trimming = 0;
+        before = cache->diskBytes;
+        pthread_mutex_unlock(&cache->lock);
+    }
+}
+
+static void count_result(t_cache *cache, int found) {
+    pthread_mutex_lock(&cache->lock);
+    if (found) cache->hits++;
+    else cache->misses++;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// Recherche un résultat : mémoire d'abord, puis disque.
+// L'entrée trouvée est réservée sous verrou puis copiée en dehors.
+int cache_fetch(t_cache *cache, uint64_t key, void *dst, size_t size) {
+    pthread_mutex_lock(&cache->lock);
+    t_cache_entry *entry = lookup(cache, key);
+    if (entry && entry->size == size) {
+        lru_unlink(cache, entry);
+        lru_pushFront(cache, entry);
+        entry->refs++;
+        cache->hits++;
+        pthread_mutex_unlock(&cache->lock);
+
+        memcpy(dst, entry->data, size);
+
+        pthread_mutex_lock(&cache->lock);
+        entry->refs--;
+        int orphan = entry->refs == 0 && entry->detached;
+        pthread_mutex_unlock(&cache->lock);
+        if (orphan) free_entry(entry);
+        return 1;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (cache->diskDir && disk_fetch(cache, key, dst, size)) {
+        memory_store(cache, key, dst, size);
+        count_result(cache, 1);
+        return 1;
+    }
+
+    count_result(cache, 0);
+    return 0;
+}
+
+// Enregistre un résultat en mémoire et, si activé, sur disque
+void cache_store(t_cache *cache, uint64_t key, const void *src, size_t size) {
+    memory_store(cache, key, src, size);
+    if (cache->diskDir) disk_store(cache, key, src, size);
+}
+
+int cache_fetchBmp8(t_cache *cache, uint64_t key, t_bmp8 *img) {
+    return cache_fetch(cache, key, img->data, img->dataSize);
+}
+
+void cache_storeBmp8(t_cache *cache, uint64_t key, const t_bmp8 *img) {
+    cache_store(cache, key, img->data, img->dataSize);
+}
+
+// Les lignes d'une image 24 bits ne sont pas contiguës : on passe par un tampon
+int cache_fetchBmp24(t_cache *cache, uint64_t key, t_bmp24 *img) {
+    size_t rowSize = img->width * sizeof(t_pixel);
+    unsigned char *buffer = malloc(rowSize * img->height);
+    if (!buffer) return 0;
+
+    int found = cache_fetch(cache, key, buffer, rowSize * img->height);
+    if (found) {
+        for (int y = 0; y < img->height; y++) {
+            memcpy(img->data[y], buffer + y * rowSize, rowSize);
+        }
+    }
+    free(buffer);
+    return found;
+}
+
+void cache_storeBmp24(t_cache *cache, uint64_t key, const t_bmp24 *img) {
+    size_t rowSize = img->width * sizeof(t_pixel);
+    unsigned char *buffer = malloc(rowSize * img->height);
+    if (!buffer) return;
+
+    for (int y = 0; y < img->height; y++) {
+        memcpy(buffer + y * rowSize, img->data[y], rowSize);
+    }
+    cache_store(cache, key, buffer, rowSize * img->height);
+    free(buffer);
+}
+
+void cache_counters(t_cache *cache, unsigned long *hits, unsigned long *misses) {
+    pthread_mutex_lock(&cache->lock);
+    *hits = cache->hits;
+    *misses = cache->misses;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// Affiche l'état du cache
+void cache_printStats(t_cache *cache) {
+    pthread_mutex_lock(&cache->lock);
+    unsigned long total = cache->hits + cache->misses;
+    printf("Statistiques du cache\n");
+    printf("    Succès        : %lu\n", cache->hits);
+    printf("    Échecs        : %lu\n", cache->misses);
+    printf("    Taux          : %.1f %%\n", total ? 100.0 * cache->hits / total : 0.0);
+    printf("    Évictions     : %lu\n", cache->evictions);
+    printf("    Mémoire       : %zu / %zu octets\n", cache->usedBytes, cache->maxBytes);
+    if (cache->diskDir) {
+        printf("    Disque        : %zu / %zu octets (%lu évictions)\n", cache->diskBytes, cache->maxDiskBytes, cache->diskEvictions);
+    }
+    printf("\n");
+    pthread_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,91 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+// Version des résultats produits par les filtres, intégrée à chaque clé.
+// À incrémenter dès qu'un filtre change de sortie, pour invalider les caches disque existants.
+//   2 : convolutions sans relecture des pixels déjà filtrés, vues par région
+#define CACHE_KEY_VERSION 2
+
+// Séquence d'opérations, condensée en un hachage courant (longueur illimitée)
+typedef struct {
+    uint64_t hash;
+    unsigned int count;
+} t_op_chain;
+
+// Entrée du cache : résultat d'une chaîne d'opérations sur une image donnée
+typedef struct t_cache_entry {
+    uint64_t key;
+    unsigned char *data;
+    size_t size;
+    struct t_cache_entry *prev;       // Liste LRU (plus récent en tête)
+    struct t_cache_entry *next;
+    struct t_cache_entry *bucketNext; // Chaînage dans la table de hachage
+    unsigned int refs;                // Copies en cours hors du verrou
+    int detached;                     // Retirée du cache, libérée à la dernière copie
+} t_cache_entry;
+
+// Cache de résultats adressé par contenu (mémoire + disque optionnel).
+// Utilisable depuis plusieurs threads : le verrou ne protège que l'index en mémoire
+// et les compteurs, les copies et les accès disque se font en dehors.
+typedef struct {
+    pthread_mutex_t lock;
+    t_cache_entry **buckets;
+    unsigned int bucketCount;
+    t_cache_entry *head;     // Entrée la plus récemment utilisée
+    t_cache_entry *tail;     // Entrée la moins récemment utilisée
+    size_t maxBytes;         // Plafond de la mémoire occupée par les résultats
+    size_t usedBytes;
+    char *diskDir;           // Répertoire de stockage sur disque (NULL = désactivé)
+    size_t maxDiskBytes;     // Plafond de la place occupée dans diskDir
+    size_t diskBytes;        // Estimation de la place occupée, recalculée à chaque éviction
+    unsigned long tempCounter;
+    int trimming;            // Un thread parcourt déjà le répertoire
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    unsigned long diskEvictions;
+} t_cache;
+
+// Hachage rapide 64 bits (algorithme XXH64)
+uint64_t cache_hash(const void *data, size_t size, uint64_t seed);
+
+// Construction de la chaîne d'opérations
+void cache_chainInit(t_op_chain *chain);
+void cache_chainAppend(t_op_chain *chain, const char *name, const float *params, int count);
+
+// Hachage des pixels et des dimensions d'une image
+uint64_t cache_hashBmp8(const t_bmp8 *img);
+uint64_t cache_hashBmp24(const t_bmp24 *img);
+
+// Clés : hachage d'une image combiné à la chaîne d'opérations
+uint64_t cache_key(uint64_t imageHash, const t_op_chain *chain);
+uint64_t cache_keyBmp8(const t_bmp8 *img, const t_op_chain *chain);
+uint64_t cache_keyBmp24(const t_bmp24 *img, const t_op_chain *chain);
+
+// Création et destruction du cache (diskDir peut être NULL, maxDiskBytes est alors ignoré)
+t_cache *cache_create(size_t maxBytes, const char *diskDir, size_t maxDiskBytes);
+void cache_free(t_cache *cache);
+
+// Accès génériques : cache_fetch renvoie 1 si le résultat a été trouvé
+int cache_fetch(t_cache *cache, uint64_t key, void *dst, size_t size);
+void cache_store(t_cache *cache, uint64_t key, const void *src, size_t size);
+
+// Accès spécialisés pour les images 8 et 24 bits
+int cache_fetchBmp8(t_cache *cache, uint64_t key, t_bmp8 *img);
+void cache_storeBmp8(t_cache *cache, uint64_t key, const t_bmp8 *img);
+int cache_fetchBmp24(t_cache *cache, uint64_t key, t_bmp24 *img);
+void cache_storeBmp24(t_cache *cache, uint64_t key, const t_bmp24 *img);
+
+// Lecture cohérente des compteurs de succès / échecs
+void cache_counters(t_cache *cache, unsigned long *hits, unsigned long *misses);
+
+// Affiche les compteurs de succès / échecs
+void cache_printStats(t_cache *cache);
+
+#endif
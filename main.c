@@ -2,6 +2,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include "bmp8.h"
+#include "cache.h"
+#include "server.h"
+
+// Plafonds du cache de résultats : 64 Mo en mémoire, 512 Mo sur disque
+#define TAILLE_CACHE (64u * 1024u * 1024u)
+#define TAILLE_CACHE_DISQUE (512u * 1024u * 1024u)
 
 void afficherMenuPrincipal() {
     printf("\nVeuillez choisir une option :\n");
@@ -45,10 +51,62 @@ void libererMatrice(float** matrice, int taille) {
     free(matrice);
 }
 
-int main() {
+// État du cache pour la session : empreinte de l'image chargée et opérations appliquées depuis
+typedef struct {
+    t_cache* cache;      // NULL si le cache n'est pas activé
+    uint64_t empreinte;
+    t_op_chain chaine;
+    uint64_t cle;        // Clé de la dernière opération recherchée
+} t_suivi;
+
+// Repart de l'image tout juste chargée
+void demarrerSuivi(t_suivi* suivi, t_bmp8* image) {
+    if (!suivi->cache) return;
+    suivi->empreinte = cache_hashBmp8(image);
+    cache_chainInit(&suivi->chaine);
+}
+
+// Ajoute l'opération à la chaîne et cherche le résultat correspondant dans le cache
+int chercherDansCache(t_suivi* suivi, t_bmp8* image, const char* nom, const float* params, int nb) {
+    if (!suivi->cache) return 0;
+    cache_chainAppend(&suivi->chaine, nom, params, nb);
+    suivi->cle = cache_key(suivi->empreinte, &suivi->chaine);
+    return cache_fetchBmp8(suivi->cache, suivi->cle, image);
+}
+
+// Enregistre le résultat de la dernière opération
+void memoriser(t_suivi* suivi, t_bmp8* image) {
+    if (suivi->cache) cache_storeBmp8(suivi->cache, suivi->cle, image);
+}
+
+// Applique une convolution en passant par le cache
+void appliquerConvolution(t_suivi* suivi, t_bmp8* image, float valeurs[], int taille) {
+    if (!chercherDansCache(suivi, image, "filter", valeurs, taille * taille)) {
+        float** kernel = creerMatrice(valeurs, taille);
+        bmp8_applyFilter(image, kernel, taille);
+        libererMatrice(kernel, taille);
+        memoriser(suivi, image);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // Mode serveur : main --serveur <socket> [threads] (un thread par cœur par défaut)
+    if (argc >= 3 && strcmp(argv[1], "--serveur") == 0) {
+        return server_run(argv[2], argc >= 4 ? atoi(argv[3]) : 0);
+    }
+
     t_bmp8* image = NULL;
     int choixPrincipal, choixFiltre;
     char chemin[256];
+    t_suivi suivi;
+
+    // Cache de résultats, sur demande : BMP_CACHE l'active en mémoire,
+    // BMP_CACHE_DIR l'active en mémoire et sur disque
+    memset(&suivi, 0, sizeof(suivi));
+    if (getenv("BMP_CACHE") || getenv("BMP_CACHE_DIR")) {
+        suivi.cache = cache_create(TAILLE_CACHE, getenv("BMP_CACHE_DIR"), TAILLE_CACHE_DISQUE);
+        if (!suivi.cache) return 1;
+    }
 
     do {
         afficherMenuPrincipal();
@@ -64,6 +122,7 @@ int main() {
                 if (image != NULL) bmp8_free(image);
                 image = bmp8_loadImage(chemin);
                 if (image) {
+                    demarrerSuivi(&suivi, image);
                     printf("Image chargée avec succès !\n");
                 } else {
                     printf("Erreur lors du chargement de l'image.\n");
@@ -94,7 +153,10 @@ int main() {
 
                     switch (choixFiltre) {
                         case 1:
-                            bmp8_negative(image);
+                            if (!chercherDansCache(&suivi, image, "negative", NULL, 0)) {
+                                bmp8_negative(image);
+                                memoriser(&suivi, image);
+                            }
                             printf("Filtre appliqué avec succès !\n");
                             break;
 
@@ -103,7 +165,11 @@ int main() {
                             printf("Valeur de luminosité (entre -255 et 255) : ");
                             scanf("%d", &val);
                             getchar();
-                            bmp8_brightness(image, val);
+                            float param = val;
+                            if (!chercherDansCache(&suivi, image, "brightness", &param, 1)) {
+                                bmp8_brightness(image, val);
+                                memoriser(&suivi, image);
+                            }
                             printf("Filtre appliqué avec succès !\n");
                             break;
                         }
@@ -113,7 +179,11 @@ int main() {
                             printf("Seuil de binarisation (0-255) : ");
                             scanf("%d", &seuil);
                             getchar();
-                            bmp8_threshold(image, seuil);
+                            float param = seuil;
+                            if (!chercherDansCache(&suivi, image, "threshold", &param, 1)) {
+                                bmp8_threshold(image, seuil);
+                                memoriser(&suivi, image);
+                            }
                             printf("Filtre appliqué avec succès !\n");
                             break;
                         }
@@ -124,9 +194,7 @@ int main() {
                                 1/9.0, 1/9.0, 1/9.0,
                                 1/9.0, 1/9.0, 1/9.0
                             };
-                            float** kernel = creerMatrice(flou, 3);
-                            bmp8_applyFilter(image, kernel, 3);
-                            libererMatrice(kernel, 3);
+                            appliquerConvolution(&suivi, image, flou, 3);
                             printf("Filtre appliqué avec succès !\n");
                             break;
                         }
@@ -138,9 +206,7 @@ int main() {
                                 1, 2, 1
                             };
                             for (int i = 0; i < 9; i++) gaussien[i] /= 16.0;
-                            float** kernel = creerMatrice(gaussien, 3);
-                            bmp8_applyFilter(image, kernel, 3);
-                            libererMatrice(kernel, 3);
+                            appliquerConvolution(&suivi, image, gaussien, 3);
                             printf("Filtre appliqué avec succès !\n");
                             break;
                         }
@@ -151,9 +217,7 @@ int main() {
                                -1, 5, -1,
                                 0, -1, 0
                             };
-                            float** kernel = creerMatrice(sharpen, 3);
-                            bmp8_applyFilter(image, kernel, 3);
-                            libererMatrice(kernel, 3);
+                            appliquerConvolution(&suivi, image, sharpen, 3);
                             printf("Filtre appliqué avec succès !\n");
                             break;
                         }
@@ -164,9 +228,7 @@ int main() {
                                 -1, 8, -1,
                                 -1, -1, -1
                             };
-                            float** kernel = creerMatrice(edge, 3);
-                            bmp8_applyFilter(image, kernel, 3);
-                            libererMatrice(kernel, 3);
+                            appliquerConvolution(&suivi, image, edge, 3);
                             printf("Filtre appliqué avec succès !\n");
                             break;
                         }
@@ -177,9 +239,7 @@ int main() {
                                 -1, 1, 1,
                                  0, 1, 2
                             };
-                            float** kernel = creerMatrice(emboss, 3);
-                            bmp8_applyFilter(image, kernel, 3);
-                            libererMatrice(kernel, 3);
+                            appliquerConvolution(&suivi, image, emboss, 3);
                             printf("Filtre appliqué avec succès !\n");
                             break;
                         }
@@ -202,6 +262,7 @@ int main() {
                 break;
 
             case 5: // Quitter
+                if (suivi.cache) cache_printStats(suivi.cache);
                 printf("Au revoir !\n");
                 break;
 
@@ -214,6 +275,7 @@ int main() {
     if (image) {
         bmp8_free(image);
     }
+    if (suivi.cache) cache_free(suivi.cache);
 
     return 0;
 }
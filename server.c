@@ -0,0 +1,672 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "bmp8.h"
+#include "cache.h"
+#include "server.h"
+
+// Nombre maximal d'opérations dans une requête
+#define MAX_OPS 32
+
+// Nombre maximal de clients connectés simultanément
+#define MAX_CLIENTS 256
+
+// Plafonds du cache de résultats partagé : 256 Mo en mémoire, 1 Go sur disque
+#define SERVER_CACHE_BYTES (256u * 1024u * 1024u)
+#define SERVER_CACHE_DISK_BYTES (1024u * 1024u * 1024u)
+
+typedef enum {
+    OP_NEGATIVE,
+    OP_BRIGHTNESS,
+    OP_THRESHOLD,
+    OP_FILTER
+} t_op_kind;
+
+typedef struct {
+    t_op_kind kind;
+    int param;         // Valeur de luminosité / seuil, ou indice du noyau
+} t_op;
+
+// Noyau de convolution préparé au démarrage et partagé par les threads
+typedef struct {
+    const char *name;
+    float values[9];
+    float *rows[3];    // Lignes de values, au format attendu par bmp8_applyFilter
+} t_server_kernel;
+
+static t_server_kernel kernels[] = {
+    { "box",      { 1/9.0, 1/9.0, 1/9.0, 1/9.0, 1/9.0, 1/9.0, 1/9.0, 1/9.0, 1/9.0 }, { NULL } },
+    { "gaussian", { 1/16.0, 2/16.0, 1/16.0, 2/16.0, 4/16.0, 2/16.0, 1/16.0, 2/16.0, 1/16.0 }, { NULL } },
+    { "sharpen",  { 0, -1, 0, -1, 5, -1, 0, -1, 0 }, { NULL } },
+    { "edge",     { -1, -1, -1, -1, 8, -1, -1, -1, -1 }, { NULL } },
+    { "emboss",   { -2, -1, 0, -1, 1, 1, 0, 1, 2 }, { NULL } }
+};
+
+#define KERNEL_COUNT (int)(sizeof(kernels) / sizeof(kernels[0]))
+
+// Thread de traitement et son tampon d'image, réutilisé d'une requête à l'autre
+typedef struct {
+    pthread_t thread;
+    unsigned char *buffer;
+    size_t capacity;
+} t_worker;
+
+// Connexion cliente. Le thread principal lit les octets reçus et confie une
+// requête complète à la fois à un thread de traitement ; la connexion n'est
+// plus surveillée tant que la réponse n'a pas été envoyée.
+typedef struct {
+    int fd;                         // -1 si l'emplacement est libre
+    char input[SERVER_LINE_MAX];    // Octets reçus, pas encore traités
+    size_t used;
+    char request[SERVER_LINE_MAX];  // Requête confiée à un thread
+    int busy;
+} t_connection;
+
+// File des connexions ayant une requête prête, consommée par les threads de traitement.
+// Une connexion y figure au plus une fois : MAX_CLIENTS places suffisent.
+typedef struct {
+    int items[MAX_CLIENTS];
+    int head;
+    int count;
+    int stopping;
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+} t_task_queue;
+
+// Compteurs globaux de latence
+typedef struct {
+    unsigned long requests;
+    unsigned long errors;
+    unsigned long long totalMicros;
+    unsigned long long maxMicros;
+    pthread_mutex_t lock;
+} t_server_stats;
+
+static t_task_queue queue;
+static t_connection connections[MAX_CLIENTS];
+static t_server_stats stats;
+static t_cache *resultCache;        // NULL si le cache n'est pas activé ; partagé par les threads
+
+// Réveil de la boucle principale : les threads y écrivent l'indice de la
+// connexion servie, le gestionnaire de signal y écrit -1
+static int wakePipe[2] = { -1, -1 };
+
+static void on_signal(int sig) {
+    (void)sig;
+    int stop = -1;
+    ssize_t ignored = write(wakePipe[1], &stop, sizeof(stop));
+    (void)ignored;
+}
+
+static unsigned long long now_micros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static void queue_push(int index) {
+    pthread_mutex_lock(&queue.lock);
+    queue.items[(queue.head + queue.count) % MAX_CLIENTS] = index;
+    queue.count++;
+    pthread_cond_signal(&queue.notEmpty);
+    pthread_mutex_unlock(&queue.lock);
+}
+
+// Retourne -1 dès que l'arrêt est demandé
+static int queue_pop(void) {
+    pthread_mutex_lock(&queue.lock);
+    while (queue.count == 0 && !queue.stopping) {
+        pthread_cond_wait(&queue.notEmpty, &queue.lock);
+    }
+    int index = -1;
+    if (!queue.stopping) {
+        index = queue.items[queue.head];
+        queue.head = (queue.head + 1) % MAX_CLIENTS;
+        queue.count--;
+    }
+    pthread_mutex_unlock(&queue.lock);
+    return index;
+}
+
+static void queue_stop(void) {
+    pthread_mutex_lock(&queue.lock);
+    queue.stopping = 1;
+    pthread_cond_broadcast(&queue.notEmpty);
+    pthread_mutex_unlock(&queue.lock);
+}
+
+// Analyse "negative,brightness:20,gaussian" et construit la chaîne canonique
+static int parse_ops(char *text, t_op *ops, int *count, t_op_chain *chain, char *error, size_t errorSize) {
+    char *save = NULL;
+    *count = 0;
+    cache_chainInit(chain);
+
+    for (char *token = strtok_r(text, ",", &save); token; token = strtok_r(NULL, ",", &save)) {
+        if (*count == MAX_OPS) {
+            snprintf(error, errorSize, "trop d'opérations (max %d)", MAX_OPS);
+            return 0;
+        }
+
+        char *arg = strchr(token, ':');
+        if (arg) *arg++ = '\0';
+        t_op *op = &ops[(*count)++];
+
+        if (strcmp(token, "negative") == 0) {
+            op->kind = OP_NEGATIVE;
+            cache_chainAppend(chain, token, NULL, 0);
+            continue;
+        }
+        if (strcmp(token, "brightness") == 0 || strcmp(token, "threshold") == 0) {
+            if (!arg) {
+                snprintf(error, errorSize, "paramètre manquant pour %s", token);
+                return 0;
+            }
+            op->kind = token[0] == 'b' ? OP_BRIGHTNESS : OP_THRESHOLD;
+            op->param = atoi(arg);
+            float param = op->param;
+            cache_chainAppend(chain, token, &param, 1);
+            continue;
+        }
+
+        int k = 0;
+        while (k < KERNEL_COUNT && strcmp(token, kernels[k].name) != 0) k++;
+        if (k == KERNEL_COUNT) {
+            snprintf(error, errorSize, "opération inconnue : %s", token);
+            return 0;
+        }
+        op->kind = OP_FILTER;
+        op->param = k;
+        cache_chainAppend(chain, "filter", kernels[k].values, 9);
+    }
+
+    if (*count == 0) {
+        snprintf(error, errorSize, "aucune opération");
+        return 0;
+    }
+    return 1;
+}
+
+// Applique la chaîne d'opérations, ou recopie le résultat s'il est déjà en cache
+static void run_ops(t_bmp8 *img, const t_op *ops, int count, const t_op_chain *chain) {
+    uint64_t key = 0;
+    if (resultCache) {
+        key = cache_keyBmp8(img, chain);
+        if (cache_fetchBmp8(resultCache, key, img)) return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        switch (ops[i].kind) {
+            case OP_NEGATIVE:   bmp8_negative(img); break;
+            case OP_BRIGHTNESS: bmp8_brightness(img, ops[i].param); break;
+            case OP_THRESHOLD:  bmp8_threshold(img, ops[i].param); break;
+            case OP_FILTER:     bmp8_applyFilter(img, kernels[ops[i].param].rows, 3); break;
+        }
+    }
+
+    if (resultCache) {
+        cache_storeBmp8(resultCache, key, img);
+    }
+}
+
+// PROCESS <entrée> <opérations> <sortie>
+static int handle_process(t_worker *worker, char *args, char *error, size_t errorSize) {
+    char *save = NULL;
+    char *input = strtok_r(args, " ", &save);
+    char *opsText = strtok_r(NULL, " ", &save);
+    char *output = strtok_r(NULL, " ", &save);
+    if (!input || !opsText || !output) {
+        snprintf(error, errorSize, "usage : PROCESS <entrée> <opérations> <sortie>");
+        return 0;
+    }
+
+    t_op ops[MAX_OPS];
+    int count;
+    t_op_chain chain;
+    if (!parse_ops(opsText, ops, &count, &chain, error, errorSize)) return 0;
+
+    // Chargement dans le tampon du thread : pas d'allocation une fois celui-ci à la bonne taille
+    t_bmp8 img;
+    if (!bmp8_loadImageInto(input, &img, &worker->buffer, &worker->capacity)) {
+        snprintf(error, errorSize, "chargement impossible : %s", input);
+        return 0;
+    }
+
+    run_ops(&img, ops, count, &chain);
+    if (!bmp8_saveImageTo(output, &img)) {
+        snprintf(error, errorSize, "écriture impossible : %s", output);
+        return 0;
+    }
+    return 1;
+}
+
+// SHM <nom> <largeur> <hauteur> <opérations> : traitement sur place, sans copie
+static int handle_shm(char *args, char *error, size_t errorSize) {
+    char *save = NULL;
+    char *name = strtok_r(args, " ", &save);
+    char *widthText = strtok_r(NULL, " ", &save);
+    char *heightText = strtok_r(NULL, " ", &save);
+    char *opsText = strtok_r(NULL, " ", &save);
+    if (!name || !widthText || !heightText || !opsText) {
+        snprintf(error, errorSize, "usage : SHM <nom> <largeur> <hauteur> <opérations>");
+        return 0;
+    }
+
+    // Lignes alignées sur 4 octets, comme dans un fichier BMP ; la taille
+    // totale doit tenir dans le champ dataSize (unsigned int) de t_bmp8
+    char *endWidth, *endHeight;
+    long width = strtol(widthText, &endWidth, 10);
+    long height = strtol(heightText, &endHeight, 10);
+    if (*endWidth || *endHeight || width <= 0 || height <= 0 || width > UINT_MAX - 3) {
+        snprintf(error, errorSize, "dimensions invalides");
+        return 0;
+    }
+    size_t stride = ((size_t)width + 3) & ~(size_t)3;
+    if ((size_t)height > UINT_MAX / stride) {
+        snprintf(error, errorSize, "image trop grande");
+        return 0;
+    }
+    size_t size = stride * (size_t)height;
+
+    t_op ops[MAX_OPS];
+    int count;
+    t_op_chain chain;
+    if (!parse_ops(opsText, ops, &count, &chain, error, errorSize)) return 0;
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        snprintf(error, errorSize, "shm_open(%s) : %s", name, strerror(errno));
+        return 0;
+    }
+
+    // Un segment plus petit que l'image provoquerait un SIGBUS en cours de traitement
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < size) {
+        snprintf(error, errorSize, "segment %s trop petit (%zu octets attendus)", name, size);
+        close(fd);
+        return 0;
+    }
+
+    unsigned char *pixels = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pixels == MAP_FAILED) {
+        snprintf(error, errorSize, "mmap : %s", strerror(errno));
+        return 0;
+    }
+
+    // L'image pointe directement sur le segment partagé du client
+    t_bmp8 img;
+    memset(&img, 0, sizeof(img));
+    img.data = pixels;
+    img.width = width;
+    img.height = height;
+    img.colorDepth = 8;
+    img.dataSize = size;
+
+    run_ops(&img, ops, count, &chain);
+    munmap(pixels, size);
+    return 1;
+}
+
+static void handle_stats(char *reply, size_t replySize) {
+    pthread_mutex_lock(&stats.lock);
+    unsigned long requests = stats.requests;
+    unsigned long errors = stats.errors;
+    unsigned long long avg = requests ? stats.totalMicros / requests : 0;
+    unsigned long long max = stats.maxMicros;
+    pthread_mutex_unlock(&stats.lock);
+
+    unsigned long hits = 0, misses = 0;
+    if (resultCache) cache_counters(resultCache, &hits, &misses);
+
+    snprintf(reply, replySize, "OK requests=%lu errors=%lu avg_us=%llu max_us=%llu cache_hits=%lu cache_misses=%lu\n",
+             requests, errors, avg, max, hits, misses);
+}
+
+// Traite une ligne de requête et prépare la réponse
+static void handle_request(t_worker *worker, char *line, char *reply, size_t replySize) {
+    unsigned long long start = now_micros();
+    char error[256] = "";
+    int ok;
+
+    line[strcspn(line, "\r\n")] = '\0';
+    char *args = strchr(line, ' ');
+    if (args) *args++ = '\0';
+    else args = line + strlen(line);
+
+    if (strcmp(line, "STATS") == 0) {
+        handle_stats(reply, replySize);
+        return;
+    } else if (strcmp(line, "PROCESS") == 0) {
+        ok = handle_process(worker, args, error, sizeof(error));
+    } else if (strcmp(line, "SHM") == 0) {
+        ok = handle_shm(args, error, sizeof(error));
+    } else {
+        snprintf(error, sizeof(error), "commande inconnue : %s", line);
+        ok = 0;
+    }
+
+    unsigned long long elapsed = now_micros() - start;
+
+    pthread_mutex_lock(&stats.lock);
+    stats.requests++;
+    if (!ok) stats.errors++;
+    stats.totalMicros += elapsed;
+    if (elapsed > stats.maxMicros) stats.maxMicros = elapsed;
+    pthread_mutex_unlock(&stats.lock);
+
+    if (ok) snprintf(reply, replySize, "OK %llu\n", elapsed);
+    else snprintf(reply, replySize, "ERR %s\n", error);
+}
+
+static int write_all(int fd, const char *buffer, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, buffer, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        buffer += n;
+        size -= n;
+    }
+    return 1;
+}
+
+// Boucle d'un thread de traitement : une requête à la fois, quelle que soit la connexion
+static void *worker_main(void *arg) {
+    t_worker *worker = (t_worker *)arg;
+    char reply[SERVER_LINE_MAX];
+
+    for (;;) {
+        int index = queue_pop();
+        if (index < 0) break;  // Arrêt demandé
+
+        t_connection *conn = &connections[index];
+        handle_request(worker, conn->request, reply, sizeof(reply));
+        // Un échec d'écriture sera constaté par la boucle principale (fin de connexion)
+        write_all(conn->fd, reply, strlen(reply));
+
+        // Rend la connexion à la boucle principale
+        ssize_t ignored = write(wakePipe[1], &index, sizeof(index));
+        (void)ignored;
+    }
+    return NULL;
+}
+
+static int open_socket(const char *socketPath) {
+    struct sockaddr_un addr;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+        printf("Erreur : chemin de socket trop long.\n");
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        printf("Erreur : création de la socket impossible (%s).\n", strerror(errno));
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath);
+
+    // Seule une socket laissée par une exécution précédente peut être remplacée
+    struct stat st;
+    if (lstat(socketPath, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            printf("Erreur : %s existe et n'est pas une socket.\n", socketPath);
+            close(fd);
+            return -1;
+        }
+        unlink(socketPath);
+    }
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, MAX_CLIENTS) < 0) {
+        printf("Erreur : écoute sur %s impossible (%s).\n", socketPath, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void close_connection(t_connection *conn) {
+    close(conn->fd);
+    conn->fd = -1;
+    conn->used = 0;
+    conn->busy = 0;
+}
+
+// Confie la prochaine requête complète de la connexion à un thread, s'il y en a une
+static void dispatch_next(int index) {
+    t_connection *conn = &connections[index];
+    if (conn->fd < 0 || conn->busy) return;
+
+    char *end = memchr(conn->input, '\n', conn->used);
+    if (!end) {
+        if (conn->used == sizeof(conn->input)) {
+            const char *tooLong = "ERR requête trop longue\n";
+            write_all(conn->fd, tooLong, strlen(tooLong));
+            close_connection(conn);
+        }
+        return;
+    }
+
+    size_t length = end - conn->input;
+    memcpy(conn->request, conn->input, length);
+    conn->request[length] = '\0';
+    conn->used -= length + 1;
+    memmove(conn->input, end + 1, conn->used);
+
+    conn->busy = 1;
+    queue_push(index);
+}
+
+static void accept_client(int listenFd) {
+    int fd = accept(listenFd, NULL, NULL);
+    if (fd < 0) return;
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (connections[i].fd < 0) {
+            connections[i].fd = fd;
+            connections[i].used = 0;
+            connections[i].busy = 0;
+            return;
+        }
+    }
+
+    const char *full = "ERR trop de clients connectés\n";
+    write_all(fd, full, strlen(full));
+    close(fd);
+}
+
+static void read_client(int index) {
+    t_connection *conn = &connections[index];
+    ssize_t n = read(conn->fd, conn->input + conn->used, sizeof(conn->input) - conn->used);
+    if (n < 0 && errno == EINTR) return;
+    if (n <= 0) {
+        close_connection(conn);
+        return;
+    }
+    conn->used += n;
+    dispatch_next(index);
+}
+
+// Vide la file de réveil ; retourne 1 si l'arrêt a été demandé
+static int drain_wake_pipe(void) {
+    int indices[64];
+    int stop = 0;
+    ssize_t n;
+
+    while ((n = read(wakePipe[0], indices, sizeof(indices))) > 0) {
+        for (int i = 0; i < n / (ssize_t)sizeof(int); i++) {
+            if (indices[i] < 0) {
+                stop = 1;
+                continue;
+            }
+            connections[indices[i]].busy = 0;
+            dispatch_next(indices[i]);
+        }
+    }
+    return stop;
+}
+
+// Boucle principale : surveille la socket d'écoute, les clients inactifs et la file de réveil
+static void event_loop(int listenFd) {
+    struct pollfd fds[MAX_CLIENTS + 2];
+    int owners[MAX_CLIENTS + 2];
+
+    for (;;) {
+        int count = 0;
+        fds[count].fd = wakePipe[0];
+        fds[count++].events = POLLIN;
+        fds[count].fd = listenFd;
+        fds[count++].events = POLLIN;
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            if (connections[i].fd >= 0 && !connections[i].busy) {
+                owners[count] = i;
+                fds[count].fd = connections[i].fd;
+                fds[count++].events = POLLIN;
+            }
+        }
+
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) continue;
+            printf("Erreur : poll (%s).\n", strerror(errno));
+            return;
+        }
+
+        // Les clients d'abord : la file de réveil peut leur confier une nouvelle requête
+        for (int k = 2; k < count; k++) {
+            if (fds[k].revents) read_client(owners[k]);
+        }
+        if (fds[1].revents & POLLIN) accept_client(listenFd);
+        if ((fds[0].revents & POLLIN) && drain_wake_pipe()) return;
+    }
+}
+
+// Arrête les threads démarrés et libère leurs tampons
+static void stop_workers(t_worker *workers, int started) {
+    queue_stop();
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        free(workers[i].buffer);
+    }
+    free(workers);
+}
+
+static void release_resources(int listenFd) {
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (connections[i].fd >= 0) close_connection(&connections[i]);
+    }
+    if (listenFd >= 0) close(listenFd);
+    for (int i = 0; i < 2; i++) {
+        if (wakePipe[i] >= 0) close(wakePipe[i]);
+        wakePipe[i] = -1;
+    }
+    if (resultCache) {
+        cache_printStats(resultCache);
+        cache_free(resultCache);
+        resultCache = NULL;
+    }
+}
+
+int server_run(const char *socketPath, int workerCount) {
+    // Par défaut, un thread par cœur disponible
+    if (workerCount <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workerCount = cpus > 0 ? (int)cpus : SERVER_DEFAULT_WORKERS;
+    }
+
+    // Préparation des ressources partagées : noyaux, cache, file, compteurs, connexions
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        for (int i = 0; i < 3; i++) {
+            kernels[k].rows[i] = &kernels[k].values[i * 3];
+        }
+    }
+
+    // Cache sur demande, comme en mode interactif
+    resultCache = NULL;
+    if (getenv("BMP_CACHE") || getenv("BMP_CACHE_DIR")) {
+        resultCache = cache_create(SERVER_CACHE_BYTES, getenv("BMP_CACHE_DIR"), SERVER_CACHE_DISK_BYTES);
+        if (!resultCache) return 1;
+    }
+
+    memset(&queue, 0, sizeof(queue));
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.notEmpty, NULL);
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_init(&stats.lock, NULL);
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        connections[i].fd = -1;
+    }
+
+    if (pipe(wakePipe) < 0) {
+        printf("Erreur : création de la file de réveil impossible (%s).\n", strerror(errno));
+        wakePipe[0] = wakePipe[1] = -1;
+        release_resources(-1);
+        return 1;
+    }
+    fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+
+    int listenFd = open_socket(socketPath);
+    if (listenFd < 0) {
+        release_resources(-1);
+        return 1;
+    }
+
+    t_worker *workers = calloc(workerCount, sizeof(t_worker));
+    if (!workers) {
+        printf("Erreur : échec lors de l'allocation des threads.\n");
+        release_resources(listenFd);
+        unlink(socketPath);
+        return 1;
+    }
+    for (int i = 0; i < workerCount; i++) {
+        int err = pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]);
+        if (err != 0) {
+            printf("Erreur : création du thread %d impossible (%s).\n", i, strerror(err));
+            stop_workers(workers, i);
+            release_resources(listenFd);
+            unlink(socketPath);
+            return 1;
+        }
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Serveur en écoute sur %s (%d threads)\n", socketPath, workerCount);
+    fflush(stdout);
+
+    event_loop(listenFd);
+
+    // Arrêt : plus de nouveaux clients, les écritures en cours sont débloquées,
+    // puis les threads terminent leur requête et s'arrêtent
+    close(listenFd);
+    unlink(socketPath);
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (connections[i].fd >= 0) shutdown(connections[i].fd, SHUT_RDWR);
+    }
+    stop_workers(workers, workerCount);
+    release_resources(-1);
+    printf("Serveur arrêté.\n");
+    return 0;
+}
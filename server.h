@@ -0,0 +1,25 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// Nombre de threads de traitement si le nombre de cœurs n'est pas connu
+#define SERVER_DEFAULT_WORKERS 4
+
+// Longueur maximale d'une requête (une ligne de texte)
+#define SERVER_LINE_MAX 4096
+
+// Lance le serveur de traitement sur une socket Unix.
+// Protocole : une requête par ligne, une réponse par ligne.
+//   PROCESS <entrée.bmp> <opérations> <sortie.bmp>
+//   SHM <nom> <largeur> <hauteur> <opérations>   (image 8 bits en mémoire partagée, traitée sur place ;
+//                                                 lignes alignées sur 4 octets, stockées de bas en haut)
+//   STATS
+// Les opérations sont séparées par des virgules : negative, brightness:N,
+// threshold:N, box, gaussian, sharpen, edge, emboss.
+// Réponses : "OK <latence en µs>" ou "ERR <message>".
+// Les connexions sont persistantes et multiplexées : workerCount threads (0 = un
+// par cœur) traitent les requêtes de tous les clients, une requête à la fois.
+// Le cache de résultats est activé par BMP_CACHE ou BMP_CACHE_DIR.
+// Retourne 0 après un arrêt propre (SIGINT / SIGTERM), 1 en cas d'erreur.
+int server_run(const char *socketPath, int workerCount);
+
+#endif